@@ -0,0 +1,29 @@
+#!/bin/bash
+# Compares mmap'ed data files viewed in place against read-into-buffer + LPArray marshaling
+# Usage: ./bench_input.sh <core_clr_path> [sizes in MB...]
+
+DIR=$( cd "$( dirname "${BASH_SOURCE[0]}")" && pwd )
+OUT_DIR=$DIR/bin
+DATA_DIR=${DATA_DIR:-$OUT_DIR/data}
+
+CORE_CLR_DIR=$1
+shift
+SIZES=${@:-1 16 256 1024 10240}
+
+mkdir -p $DATA_DIR
+
+for MB in $SIZES; do
+    FILE=$DATA_DIR/input_${MB}mb.dwcf
+    if [ ! -e "$FILE" ]; then
+        ${OUT_DIR}/host --write-input=$FILE --input-mb=$MB || exit 1
+    fi
+
+    for MODE in "" "--input-read"; do
+        # Cold cache runs need root; warm cache numbers are reported otherwise
+        if [ -w /proc/sys/vm/drop_caches ]; then
+            sync && echo 3 > /proc/sys/vm/drop_caches
+        fi
+        echo -n "${MB} MB: "
+        ${OUT_DIR}/host --input=$FILE $MODE --warmup-ms=0 --skip-demo $CORE_CLR_DIR | grep "^Input"
+    done
+done
@@ -11,10 +11,14 @@ mkdir -p $OUT_DIR
 #     cp "/usr/local/share/dotnet/shared/Microsoft.NETCore.App/2.0.0/libcoreclr.dylib" $OUT_DIR/
 # fi
 
+# generate the C# interop stubs from src/interop.def
+g++ -std=c++11 -o ${OUT_DIR}/interopgen ${SRC_DIR}/interopgen.cpp || exit 1
+${OUT_DIR}/interopgen ${SRC_DIR}/ManagedLibrary/NativeExports.g.cs || exit 1
+
 # build csharp project
 # dotnet publish --self-contained -r osx-x64 ${SRC_DIR}/ManagedLibrary/ManagedLibrary.csproj -o ${OUT_DIR}
 # dotnet publish -r osx-x64 ${SRC_DIR}/ManagedLibrary/ManagedLibrary.csproj -o ${OUT_DIR}
 dotnet build -r osx-x64 ${SRC_DIR}/ManagedLibrary/ManagedLibrary.csproj -o ${OUT_DIR}
 
 # build cpp host exe
-g++ -o ${OUT_DIR}/host ${SRC_DIR}/host.cpp -ldl
+g++ -std=c++11 -o ${OUT_DIR}/host ${SRC_DIR}/host.cpp ${SRC_DIR}/profiler.cpp ${SRC_DIR}/datafile.cpp ${SRC_DIR}/warmup.cpp -ldl -pthread
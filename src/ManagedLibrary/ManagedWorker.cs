@@ -18,18 +18,18 @@ namespace ManagedLibrary
             Console.WriteLine("Instead, please use the SampleHost process to load this assembly.");
         }
 
-        public delegate int ReportProgressFunction(int progress);
-
         // This test method doesn't actually do anything, it just takes some input parameters,
         // waits (in a loop) for a bit, invoking the callback function periodically, and
         // then returns a string version of the double[] passed in.
-        [return: MarshalAs(UnmanagedType.LPStr)]
-        public static string DoWork(
-            [MarshalAs(UnmanagedType.LPStr)] string jobName,
+        // Called through the NativeExports.DoWork stub generated from src/interop.def, so all
+        // parameters are blittable and the host's memory is used directly without copies.
+        // The returned string is allocated with CoTaskMem and freed by the host.
+        public static unsafe byte* DoWork(
+            byte* jobName,
             int iterations,
             int dataSize,
-            [MarshalAs(UnmanagedType.LPArray, SizeParamIndex = 2)] double[] data,
-            ReportProgressFunction reportProgressFunction)
+            double* data,
+            delegate* unmanaged<int, int> reportProgressFunction)
         {
             for (int i = 1; i <= iterations; i++)
             {
@@ -49,7 +49,72 @@ namespace ManagedLibrary
             Console.WriteLine($"Work completed");
             Console.ResetColor();
 
-            return $"Data received: {string.Join(", ", data.Select(d => d.ToString()))}";
+            return FormatResult(dataSize, data);
+        }
+
+        // Called by the host's warmup instead of DoWork: the same callback and result
+        // formatting code without the console output and the one second pauses, so it
+        // is past Tier-0 before the first real DoWork call. DoWork's own loop is not
+        // warmed by this, it is dominated by Thread.Sleep anyway.
+        public static unsafe byte* DoWorkWarmup(
+            byte* jobName,
+            int iterations,
+            int dataSize,
+            double* data,
+            delegate* unmanaged<int, int> reportProgressFunction)
+        {
+            for (int i = 1; i <= iterations; i++)
+            {
+                reportProgressFunction(i);
+            }
+
+            return FormatResult(dataSize, data);
+        }
+
+        // Returns a string version of the data as a CoTaskMem allocated UTF-8 string
+        private static unsafe byte* FormatResult(int dataSize, double* data)
+        {
+            var values = new ReadOnlySpan<double>(data, dataSize).ToArray();
+            var result = $"Data received: {string.Join(", ", values.Select(d => d.ToString()))}";
+            return (byte*)Marshal.StringToCoTaskMemUTF8(result);
+        }
+
+        // Sums a pointer/length view over native memory, e.g. a memory mapped data file.
+        // Span lengths are ints, so views larger than int.MaxValue are walked in chunks.
+        public static unsafe double SumData(double* data, long count)
+        {
+            double sum = 0;
+            while (count > 0)
+            {
+                int length = (int)Math.Min(count, int.MaxValue);
+                foreach (var value in new ReadOnlySpan<double>(data, length))
+                {
+                    sum += value;
+                }
+                data += length;
+                count -= length;
+            }
+            return sum;
+        }
+
+        // Includes methods compiled again at a higher tier, so it stops growing
+        // once tiered compilation has finished promoting the hot methods
+        public static long JitCompiledMethodCount()
+        {
+            return System.Runtime.JitInfo.GetCompiledMethodCount(false);
+        }
+
+        // Same as SumData but through LPArray marshaling, which copies the data into a managed array
+        public static double SumDataMarshaled(
+            int count,
+            [MarshalAs(UnmanagedType.LPArray, SizeParamIndex = 0)] double[] data)
+        {
+            double sum = 0;
+            foreach (var value in data)
+            {
+                sum += value;
+            }
+            return sum;
         }
     }
 }
\ No newline at end of file
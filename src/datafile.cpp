@@ -0,0 +1,258 @@
+#include "datafile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(__WIN32__)
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#endif
+
+// Columns of large files are aligned to 2 MB so they can be backed by huge pages
+#define DATAFILE_PAGE_ALIGNMENT     4096
+#define DATAFILE_HUGE_ALIGNMENT     (2 * 1024 * 1024)
+#define DATAFILE_HUGE_THRESHOLD     (64ULL * 1024 * 1024)
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static uint64_t ColumnStride(const DataFileHeader& header)
+{
+    return AlignUp(header.count * sizeof(double), header.alignment);
+}
+
+static uint64_t FileSize(FILE* file)
+{
+#if defined(_WIN32) || defined(__WIN32__)
+    _fseeki64(file, 0, SEEK_END);
+    uint64_t size = (uint64_t)_ftelli64(file);
+    _fseeki64(file, 0, SEEK_SET);
+#else
+    fseeko(file, 0, SEEK_END);
+    uint64_t size = (uint64_t)ftello(file);
+    fseeko(file, 0, SEEK_SET);
+#endif
+    return size;
+}
+
+static bool ValidateHeader(const DataFileHeader& header, uint64_t fileSize, const char* path)
+{
+    const char* error = NULL;
+    if (memcmp(header.magic, DATAFILE_MAGIC, sizeof(header.magic)) != 0)
+        error = "bad magic";
+    else if (header.version != DATAFILE_VERSION)
+        error = "unsupported version";
+    else if (header.type != DATAFILE_TYPE_F64)
+        error = "unsupported element type";
+    else if (header.alignment < sizeof(double) || (header.alignment & (header.alignment - 1)) != 0)
+        error = "alignment is not a power of two";
+    else if (header.offset < sizeof(DataFileHeader) || header.offset % header.alignment != 0)
+        error = "misaligned column offset";
+    else if (header.columns == 0)
+        error = "no columns";
+    // Compare by division so that huge counts in a corrupt header cannot wrap around.
+    // Past these checks count * sizeof(double) and the stride are bounded by fileSize.
+    else if (header.offset > fileSize || header.count > (fileSize - header.offset) / sizeof(double))
+        error = "file is truncated";
+    else if (header.columns > 1 && ColumnStride(header) > 0 &&
+             header.columns - 1 > (fileSize - header.offset - header.count * sizeof(double)) / ColumnStride(header))
+        error = "file is truncated";
+
+    if (error != NULL)
+    {
+        printf("ERROR: Invalid data file %s: %s\n", path, error);
+        return false;
+    }
+    return true;
+}
+
+bool DataFileWrite(const char* path, uint64_t count, uint32_t columns)
+{
+    DataFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DATAFILE_MAGIC, sizeof(header.magic));
+    header.version = DATAFILE_VERSION;
+    header.type = DATAFILE_TYPE_F64;
+    header.alignment = count * sizeof(double) >= DATAFILE_HUGE_THRESHOLD ? DATAFILE_HUGE_ALIGNMENT : DATAFILE_PAGE_ALIGNMENT;
+    header.count = count;
+    header.offset = AlignUp(sizeof(DataFileHeader), header.alignment);
+    header.columns = columns;
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        printf("ERROR: Failed to create data file %s\n", path);
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    std::vector<double> chunk(1024 * 1024);
+    std::vector<char> padding(header.alignment, 0);
+    ok = ok && fwrite(&padding[0], 1, header.offset - sizeof(header), file) == header.offset - sizeof(header);
+
+    for (uint32_t column = 0; ok && column < columns; ++column)
+    {
+        for (uint64_t i = 0; ok && i < count; i += chunk.size())
+        {
+            size_t n = (size_t)(count - i < chunk.size() ? count - i : chunk.size());
+            for (size_t j = 0; j < n; ++j)
+                chunk[j] = (double)((i + j) % 1000) * 0.25;
+            ok = fwrite(&chunk[0], sizeof(double), n, file) == n;
+        }
+
+        // Pad every column but the last up to the next aligned offset
+        size_t pad = (size_t)(ColumnStride(header) - count * sizeof(double));
+        if (ok && column + 1 < columns && pad > 0)
+            ok = fwrite(&padding[0], 1, pad, file) == pad;
+    }
+
+    if (fclose(file) != 0 || !ok)
+    {
+        printf("ERROR: Failed to write data file %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+#if defined(_WIN32) || defined(__WIN32__)
+// No mmap: load the whole file into a heap buffer behind the same interface
+bool DataFileMap(const char* path, DataFile& file)
+{
+    memset(&file, 0, sizeof(file));
+
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        printf("ERROR: Failed to open data file %s\n", path);
+        return false;
+    }
+
+    uint64_t size = FileSize(f);
+
+    void* base = malloc((size_t)size);
+    if (base == NULL || fread(base, 1, (size_t)size, f) != size || size < sizeof(DataFileHeader))
+    {
+        printf("ERROR: Failed to read data file %s\n", path);
+        free(base);
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+
+    memcpy(&file.header, base, sizeof(file.header));
+    if (!ValidateHeader(file.header, size, path))
+    {
+        free(base);
+        return false;
+    }
+
+    file.base = base;
+    file.size = (size_t)size;
+    return true;
+}
+
+void DataFileUnmap(DataFile& file)
+{
+    free(file.base);
+    file.base = NULL;
+}
+#else
+bool DataFileMap(const char* path, DataFile& file)
+{
+    memset(&file, 0, sizeof(file));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("ERROR: Failed to open data file %s\n", path);
+        return false;
+    }
+
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || (uint64_t)sb.st_size < sizeof(DataFileHeader))
+    {
+        printf("ERROR: Invalid data file %s: too small\n", path);
+        close(fd);
+        return false;
+    }
+
+    // The mapping keeps the file referenced, the descriptor is not needed afterwards
+    void* base = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        printf("ERROR: Failed to map data file %s\n", path);
+        return false;
+    }
+
+    memcpy(&file.header, base, sizeof(file.header));
+    if (!ValidateHeader(file.header, (uint64_t)sb.st_size, path))
+    {
+        munmap(base, (size_t)sb.st_size);
+        return false;
+    }
+
+    // Columns are consumed front to back: ask for aggressive readahead,
+    // and huge pages where the kernel supports them for file mappings.
+    // Both are hints, failures are not errors.
+    madvise(base, (size_t)sb.st_size, MADV_SEQUENTIAL);
+    madvise(base, (size_t)sb.st_size, MADV_WILLNEED);
+#if defined(MADV_HUGEPAGE)
+    if (file.header.alignment >= DATAFILE_HUGE_ALIGNMENT)
+        madvise(base, (size_t)sb.st_size, MADV_HUGEPAGE);
+#endif
+
+    file.base = base;
+    file.size = (size_t)sb.st_size;
+    return true;
+}
+
+void DataFileUnmap(DataFile& file)
+{
+    if (file.base != NULL)
+        munmap(file.base, file.size);
+    file.base = NULL;
+}
+#endif
+
+const double* DataFileColumn(const DataFile& file, uint32_t column)
+{
+    if (file.base == NULL || column >= file.header.columns)
+        return NULL;
+
+    const char* base = (const char*)file.base;
+    return (const double*)(base + file.header.offset + ColumnStride(file.header) * column);
+}
+
+bool DataFileRead(const char* path, std::vector<double>& buffer)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        printf("ERROR: Failed to open data file %s\n", path);
+        return false;
+    }
+
+    // Validate against the real size so a truncated file fails before the allocation
+    uint64_t size = FileSize(file);
+    DataFileHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+              ValidateHeader(header, size, path);
+    if (ok)
+    {
+        buffer.resize((size_t)header.count);
+        ok = fseek(file, (long)header.offset, SEEK_SET) == 0 &&
+             fread(buffer.empty() ? NULL : &buffer[0], sizeof(double), buffer.size(), file) == buffer.size();
+        if (!ok)
+            printf("ERROR: Failed to read data file %s\n", path);
+    }
+
+    fclose(file);
+    return ok;
+}
@@ -0,0 +1,66 @@
+//
+// Columnar binary input files for DoWork datasets
+//
+// A data file is a fixed 64 byte header followed by one or more columns of
+// the same element type. Each column starts at a multiple of the header's
+// alignment, so a memory mapped column can be handed to managed code as a
+// pointer/length view without copying it into a heap buffer first.
+//
+//  offset 0                   DataFileHeader
+//  offset header.offset       column 0: count elements, padded to alignment
+//  ...                        column 1 ... column (columns - 1)
+//
+
+#ifndef __DATAFILE_H__
+#define __DATAFILE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#define DATAFILE_MAGIC      "DWCF"
+#define DATAFILE_VERSION    1
+
+enum DataFileType
+{
+    DATAFILE_TYPE_F64 = 1,
+};
+
+struct DataFileHeader
+{
+    char        magic[4];       // DATAFILE_MAGIC
+    uint32_t    version;        // DATAFILE_VERSION
+    uint32_t    type;           // DataFileType of every column
+    uint32_t    alignment;      // byte alignment of each column, power of two
+    uint64_t    count;          // elements per column
+    uint64_t    offset;         // byte offset of column 0
+    uint32_t    columns;        // number of columns
+    uint8_t     reserved[28];
+};
+
+static_assert(sizeof(DataFileHeader) == 64, "data file header must stay 64 bytes");
+
+// A mapped (or, where mmap is unavailable, loaded) data file
+struct DataFile
+{
+    DataFileHeader  header;
+    void*           base;       // start of the mapping (a heap buffer without mmap)
+    size_t          size;       // mapping size in bytes
+};
+
+// Writes a file of `columns` columns holding `count` synthetic f64 values each
+bool DataFileWrite(const char* path, uint64_t count, uint32_t columns);
+
+// Maps a data file read-only with sequential access and huge page hints
+bool DataFileMap(const char* path, DataFile& file);
+
+// Releases a file opened with DataFileMap
+void DataFileUnmap(DataFile& file);
+
+// Pointer to the first element of a column of a mapped f64 file
+const double* DataFileColumn(const DataFile& file, uint32_t column);
+
+// Baseline for comparison: reads column 0 of a data file into a heap buffer
+bool DataFileRead(const char* path, std::vector<double>& buffer);
+
+#endif // __DATAFILE_H__
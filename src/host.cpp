@@ -4,9 +4,18 @@
 #include <string>
 #include <set>
 #include <iostream>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <chrono>
+#include <future>
 
 // https://github.com/dotnet/coreclr/blob/master/src/coreclr/hosts/inc/coreclrhost.h
 #include "coreclrhost.h"
+#include "interop.h"
+#include "profiler.h"
+#include "datafile.h"
+#include "warmup.h"
 
 #if defined(_WIN32) || defined(__WIN32__)
 #   define OS_WIN
@@ -29,6 +38,10 @@
 #   include <dirent.h>
 #   include <dlfcn.h>
 #   include <limits.h>
+#   include <unistd.h>
+#   include <arpa/inet.h>
+#   include <netinet/in.h>
+#   include <sys/socket.h>
 #   include <sys/stat.h>
 #   define FS_SEPARATOR "/"
 #   define PATH_DELIMITER ":"
@@ -51,42 +64,85 @@
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 
 #define MANAGED_ASSEMBLY "ManagedLibrary.dll"
+#define HOST_CONFIG_FILE "host.conf"
 
-// Function pointer types for the managed call and callback
-typedef int (*report_callback_ptr)(int progress);
-typedef char* (*doWork_ptr)(const char* jobName, int iterations, int dataSize, double* data, report_callback_ptr callbackFunction);
+// Function pointer types for the managed call and callback are generated from interop.def
 
 void BuildTpaList(const char* directory, const char* extension, std::string& tpaList);
 int  ReportProgressCallback(int progress);
+int  WarmupProgressCallback(int progress);
 
-int main(int argc, char** argv) {
-    const char* core_clr_dir = "./";
-    if (argc >= 2)
-    {
-        core_clr_dir = argv[1];
-        // std::cerr << "Usage: host <core_clr_path>" << std::endl;
-        // return -1;
-    }
+// Everything the host needs from a started runtime
+// Members stay NULL until the step that produces them succeeded,
+// so StopRuntime can undo a partially started runtime.
+struct Runtime
+{
+    HMODULE                 coreClr;
+    void*                   hostHandle;
+    unsigned int            domainId;
+    coreclr_shutdown_ptr    pShutdownPtr;
+    interop::DoWork         doWork;
+    interop::DoWorkWarmup   doWorkWarmup;
+    interop::SumData        sumData;
+    interop::JitCompiledMethodCount jitCompiledMethodCount;
+    interop::SumDataMarshaled sumDataMarshaled;
+
+    Runtime() : coreClr(NULL), hostHandle(NULL), domainId(0), pShutdownPtr(NULL) {}
+};
+
+// Host side startup that does not need the runtime and runs while it starts
+struct HostStartup
+{
+    std::map<std::string, std::string> config;
+    int                     listenSocket;
+    DataFile                inputFile;
+    bool                    inputMapped;
+    std::vector<double>     inputBuffer;
+    double                  configMs;
+    double                  listenMs;
+    double                  inputMs;
 
-    // Get the current executable's directory
-    // This sample assumes that both CoreCLR and the
-    // managed assembly to be loaded are next to this host
-    // so we need to get the current path in order to locate those.
-    char appPath[MAX_PATH];
-#if defined(OS_WIN)
-    GetFullPathNameA(argv[0], MAX_PATH, appPath, NULL);
-#else
-    realpath(argv[0], appPath);
-#endif
+    HostStartup() : listenSocket(-1), inputMapped(false), configMs(0), listenMs(0), inputMs(0) {}
+};
 
-    char *last_slash = strrchr(appPath, FS_SEPARATOR[0]);
-    if (last_slash != NULL)
-        *last_slash = 0;
-        
+typedef std::chrono::steady_clock Clock;
+
+static double ElapsedMs(Clock::time_point since)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+// Binds a managed entry point declared in interop.def.
+// [UnmanagedCallersOnly] stubs come back as their native entry point directly,
+// marshaled entries as a marshaling stub around the managed method.
+template <typename Entry>
+static int CreateDelegate(coreclr_create_delegate_ptr pCreateDelegatePtr, void* hostHandle, unsigned int domainId, Entry& entry)
+{
+    // The assembly name passed in the third parameter is a managed assembly name
+    // as described at https://docs.microsoft.com/dotnet/framework/app-domains/assembly-names
+    int hr = pCreateDelegatePtr(
+            hostHandle,
+            domainId,
+            INTEROP_MANAGED_ASSEMBLY,
+            Entry::type_name(),
+            Entry::method_name(),
+            entry.address());
+
+    if (hr < 0) {
+        printf("coreclr_create_delegate(%s) failed - status: 0x%08x\n", Entry::method_name(), hr);
+    }
+    return hr;
+}
+
+// STEP 1-5: Load CoreCLR, start it and bind the managed entry points.
+// Runs on a background thread while the host does its own startup work,
+// so it must not touch anything main() uses until the future is ready.
+bool StartRuntime(std::string appPath, std::string coreClrDir, Runtime* runtime)
+{
     // Construct the CoreCLR path
     // For this sample, we know CoreCLR's path. For other hosts,
     // it may be necessary to probe for coreclr.dll/libcoreclr.so
-    std::string coreClrPath(core_clr_dir);
+    std::string coreClrPath(coreClrDir);
     coreClrPath.append(FS_SEPARATOR);
     coreClrPath.append(CORECLR_FILE_NAME);
 
@@ -100,10 +156,11 @@ int main(int argc, char** argv) {
     HMODULE coreClr = DYNLIB_LOAD(coreClrPath.c_str());
     if (coreClr == NULL){
         printf("ERROR: Failed to load CoreCLR from %s\n", CORECLR_FILE_NAME);
-        return -1;
+        return false;
     } else {
         printf("Loaded CoreCLR from %s\n", CORECLR_FILE_NAME);
     }
+    runtime->coreClr = coreClr;
 
     // STEP 2: Get CoreCLR hosting functions pInitPtr pCreatePtr,pShutdownPtr
     coreclr_initialize_ptr pInitPtr = (coreclr_initialize_ptr)DYNLIB_GETSYM(coreClr, "coreclr_initialize");
@@ -112,17 +169,17 @@ int main(int argc, char** argv) {
 
     if (pInitPtr == NULL) {
         printf("coreclr_initialize not found");
-        return -1;
+        return false;
     }
 
     if (pCreateDelegatePtr == NULL) {
         printf("coreclr_create_delegate not found");
-        return -1;
+        return false;
     }
 
     if (pShutdownPtr == NULL) {
         printf("coreclr_shutdown not found");
-        return -1;
+        return false;
     }
 
     // STEP 3: Construct properties used when starting the runtime
@@ -133,7 +190,7 @@ int main(int argc, char** argv) {
     // For this host (as with most), assemblies next to CoreCLR will
     // be included in the TPA list
     std::string tpaList;
-    BuildTpaList(appPath, ".dll", tpaList);
+    BuildTpaList(appPath.c_str(), ".dll", tpaList);
 
     // <Snippet3>
     // Define CoreCLR properties
@@ -146,7 +203,7 @@ int main(int argc, char** argv) {
     };
 
     const char* propertyValues[] = {
-        appPath,
+        appPath.c_str(),
         tpaList.c_str()
     };
     // </Snippet3>
@@ -160,7 +217,7 @@ int main(int argc, char** argv) {
     // This function both starts the .NET Core runtime and creates
     // the default (and only) AppDomain
     int hr = pInitPtr(
-                appPath,                    // App base path
+                appPath.c_str(),            // App base path
                 "host",                     // AppDomain friendly name
                 ARRAY_SIZE(propertyKeys),   // Property count
                 propertyKeys,               // Property names
@@ -173,65 +230,395 @@ int main(int argc, char** argv) {
         printf("CoreCLR started\n");
     }else{
         printf("coreclr_initialize failed - status: 0x%08x\n", hr);
-        return -1;
+        return false;
     }
+    runtime->hostHandle = hostHandle;
+    runtime->domainId = domainId;
+    runtime->pShutdownPtr = pShutdownPtr;
 
-    // STEP 5: Create delegate to managed code and invoke it
+    // STEP 5: Create delegate to managed code
 
     // <Snippet5>
-    doWork_ptr managedDelegate;
-
-    // The assembly name passed in the third parameter is a managed assembly name
-    // as described at https://docs.microsoft.com/dotnet/framework/app-domains/assembly-names
-    hr = pCreateDelegatePtr(
-            hostHandle,
-            domainId,
-            "ManagedLibrary, Version=1.0.0.0",
-            "ManagedLibrary.ManagedWorker",
-            "DoWork",
-            (void**)&managedDelegate);
+    if (CreateDelegate(pCreateDelegatePtr, hostHandle, domainId, runtime->doWork) < 0 ||
+        CreateDelegate(pCreateDelegatePtr, hostHandle, domainId, runtime->doWorkWarmup) < 0 ||
+        CreateDelegate(pCreateDelegatePtr, hostHandle, domainId, runtime->sumData) < 0 ||
+        CreateDelegate(pCreateDelegatePtr, hostHandle, domainId, runtime->jitCompiledMethodCount) < 0 ||
+        CreateDelegate(pCreateDelegatePtr, hostHandle, domainId, runtime->sumDataMarshaled) < 0) {
+        return false;
+    }
     // </Snippet5>
 
-    if (hr >= 0) {
-        printf("Managed delegate created\n");
-    } else {
-        printf("coreclr_create_delegate failed - status: 0x%08x\n", hr);
+    printf("Managed delegate created\n");
+    return true;
+}
+
+// STEP 6: Shutdown CoreCLR and unload it, as far as StartRuntime got
+void StopRuntime(Runtime* runtime)
+{
+    if (runtime->hostHandle != NULL) {
+        // <Snippet6>
+        int hr = runtime->pShutdownPtr(runtime->hostHandle, runtime->domainId);
+        // </Snippet6>
+
+        if (hr >= 0){
+            printf("CoreCLR successfully shutdown\n");
+        } else {
+            printf("coreclr_shutdown failed - status: 0x%08x\n", hr);
+        }
+        runtime->hostHandle = NULL;
+    }
+
+    // Unload CoreCLR
+    if (runtime->coreClr != NULL) {
+        if(DYNLIB_UNLOAD(runtime->coreClr)) {
+            printf("Failed to free libcoreclr\n");
+        }
+        runtime->coreClr = NULL;
+    }
+}
+
+// Reads "key = value" lines; '#' starts a comment
+static bool LoadConfig(const char* path, std::map<std::string, std::string>& config)
+{
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+        return false;
+
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        std::string text(line);
+        text.erase(std::min(text.find('#'), text.length()));
+
+        size_t equals = text.find('=');
+        if (equals == std::string::npos)
+            continue;
+
+        std::string key = text.substr(0, equals);
+        std::string value = text.substr(equals + 1);
+        key.erase(0, key.find_first_not_of(" \t"));
+        key.erase(key.find_last_not_of(" \t\r\n") + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+        value.erase(value.find_last_not_of(" \t\r\n") + 1);
+        if (!key.empty())
+            config[key] = value;
+    }
+
+    fclose(file);
+    return true;
+}
+
+// Stand-in for the host's network setup: a loopback listening socket on
+// listen_port from the config (0, the default, picks a free port).
+// Nothing accepts on it yet, it only puts the real setup cost into startup.
+static int OpenListenSocket(const std::map<std::string, std::string>& config)
+{
+#if defined(OS_WIN)
+    // Winsock setup is left out of this sample
+    (void)config;
+    return -1;
+#else
+    std::map<std::string, std::string>::const_iterator it = config.find("listen_port");
+    int port = it != config.end() ? atoi(it->second.c_str()) : 0;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons((unsigned short)port);
+
+    socklen_t length = sizeof(addr);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 16) != 0 ||
+        getsockname(fd, (struct sockaddr*)&addr, &length) != 0) {
+        printf("ERROR: Failed to listen on 127.0.0.1:%d\n", port);
+        close(fd);
         return -1;
     }
 
-    // Create sample data for the double[] argument of the managed method to be called
-    double data[4];
-    data[0] = 0;
-    data[1] = 0.25;
-    data[2] = 0.5;
-    data[3] = 0.75;
+    printf("Listening on 127.0.0.1:%d\n", ntohs(addr.sin_port));
+    return fd;
+#endif
+}
 
-    // Invoke the managed delegate and write the returned string to the console
-    char* ret = managedDelegate("Test job", 5, sizeof(data) / sizeof(double), data, ReportProgressCallback);
+// Host startup: config, network and input data. Overlaps with StartRuntime.
+bool StartHost(const char* appPath, const char* configPath, const char* inputPath, bool inputRead, HostStartup* host)
+{
+    // An explicit --config must exist, the default one next to the host is optional
+    Clock::time_point stepTime = Clock::now();
+    std::string defaultConfig(appPath);
+    defaultConfig.append(FS_SEPARATOR);
+    defaultConfig.append(HOST_CONFIG_FILE);
+    if (!LoadConfig(configPath != NULL ? configPath : defaultConfig.c_str(), host->config) && configPath != NULL) {
+        printf("ERROR: Failed to read config %s\n", configPath);
+        return false;
+    }
+    host->configMs = ElapsedMs(stepTime);
 
-    printf("Managed code returned: %s\n", ret);
+    stepTime = Clock::now();
+    host->listenSocket = OpenListenSocket(host->config);
+#if !defined(OS_WIN)
+    if (host->listenSocket < 0) {
+        return false;
+    }
+#endif
+    host->listenMs = ElapsedMs(stepTime);
+
+    // Input data is either mapped and viewed in place by managed code, or, with
+    // --input-read, read into a heap buffer and copied again by LPArray marshaling
+    stepTime = Clock::now();
+    if (inputPath != NULL) {
+        if (inputRead) {
+            if (!DataFileRead(inputPath, host->inputBuffer)) {
+                return false;
+            }
+        } else {
+            if (!DataFileMap(inputPath, host->inputFile)) {
+                return false;
+            }
+            host->inputMapped = true;
+        }
+    }
+    host->inputMs = ElapsedMs(stepTime);
 
-    // Strings returned to native code must be freed by the native code
-    FREE(ret);
+    return true;
+}
 
-    // STEP 6: Shutdown CoreCLR
+void StopHost(HostStartup* host)
+{
+    if (host->inputMapped) {
+        DataFileUnmap(host->inputFile);
+        host->inputMapped = false;
+    }
 
-    // <Snippet6>
-    hr = pShutdownPtr(hostHandle, domainId);
-    // </Snippet6>
+#if !defined(OS_WIN)
+    if (host->listenSocket >= 0) {
+        close(host->listenSocket);
+        host->listenSocket = -1;
+    }
+#endif
+}
 
-    if (hr >= 0){
-        printf("CoreCLR successfully shutdown\n");
-    } else {
-        printf("coreclr_shutdown failed - status: 0x%08x\n", hr);
+// Command line options, see the usage in main()
+struct HostOptions
+{
+    const char*     coreClrDir;
+    const char*     configPath;
+    const char*     profileDir;
+    const char*     inputPath;
+    const char*     writeInputPath;
+    unsigned long   inputMb;
+    bool            inputRead;
+    bool            skipDemo;
+    bool            serialInit;
+    double          warmupMs;
+
+    HostOptions() : coreClrDir("./"), configPath(NULL), profileDir(NULL), inputPath(NULL), writeInputPath(NULL),
+                    inputMb(1), inputRead(false), skipDemo(false), serialInit(false), warmupMs(2000) {}
+};
+
+// Everything after startup: warmup, then the actual managed calls.
+// Returns the process exit code; the caller shuts the runtime down.
+int RunWorkload(const HostOptions& options, Runtime& runtime, HostStartup& host, Clock::time_point startTime)
+{
+    // Drive every entry point with synthetic inputs until tiered compilation
+    // has settled, so real calls do not pay for Tier-0 code and JIT time.
+    // --warmup-ms=0 skips it.
+    if (options.warmupMs > 0) {
+        std::vector<double> warmupData(16, 0.5);
+
+        // DoWork itself prints and sleeps, DoWorkWarmup runs the same callback
+        // and formatting code quietly
+        WarmupRegister(interop::DoWorkWarmup::method_name(), [&]() {
+            FREE(runtime.doWorkWarmup("warmup", 1, (int)warmupData.size(), &warmupData[0], WarmupProgressCallback));
+        });
+        WarmupRegister(interop::SumData::method_name(), [&]() {
+            runtime.sumData(&warmupData[0], (int64_t)warmupData.size());
+        });
+        WarmupRegister(interop::SumDataMarshaled::method_name(), [&]() {
+            runtime.sumDataMarshaled((int32_t)warmupData.size(), &warmupData[0]);
+        });
+
+        WarmupRun(options.warmupMs, [&]() { return runtime.jitCompiledMethodCount(); });
     }
 
-    // Unload CoreCLR
-    if(DYNLIB_UNLOAD(coreClr)) {
-        printf("Failed to free libcoreclr\n");
+    printf("Host ready after %.2f ms\n", ElapsedMs(startTime));
+
+    if (options.profileDir != NULL) {
+        if (!ProfilerStart(options.profileDir)) {
+            printf("ERROR: --profile was requested but perf could not be started, no profile would be written\n");
+            return -1;
+        }
+    }
+
+    int exitCode = 0;
+
+    if (options.inputPath != NULL) {
+        Clock::time_point sumTime = Clock::now();
+        double sum = 0;
+        uint64_t count;
+        if (options.inputRead) {
+            count = host.inputBuffer.size();
+            if (count > INT_MAX) {
+                printf("ERROR: %s is too large for LPArray marshaling\n", options.inputPath);
+                exitCode = -1;
+            } else {
+                sum = runtime.sumDataMarshaled((int32_t)count, count > 0 ? &host.inputBuffer[0] : NULL);
+            }
+        } else {
+            count = host.inputFile.header.count;
+            sum = runtime.sumData(DataFileColumn(host.inputFile, 0), (int64_t)count);
+        }
+
+        if (exitCode == 0) {
+            printf("Input (%s): %llu doubles, loaded in %.2f ms, SumData = %f in %.2f ms\n",
+                   options.inputRead ? "read + LPArray" : "mmap view", (unsigned long long)count,
+                   host.inputMs, sum, ElapsedMs(sumTime));
+        }
+    }
+
+    // Invoke the managed delegate and write the returned string to the console.
+    // --skip-demo leaves it out, e.g. when only the --input numbers are wanted.
+    if (exitCode == 0 && !options.skipDemo) {
+        // Create sample data for the double[] argument of the managed method to be called
+        double data[4];
+        data[0] = 0;
+        data[1] = 0.25;
+        data[2] = 0.5;
+        data[3] = 0.75;
+
+        char* ret = runtime.doWork("Test job", 5, sizeof(data) / sizeof(double), data, ReportProgressCallback);
+
+        printf("Managed code returned: %s\n", ret);
+
+        // Strings returned to native code must be freed by the native code
+        FREE(ret);
+    }
+
+    // Stop before shutdown, while the runtime's perf map still describes live code
+    if (options.profileDir != NULL && !ProfilerStop()) {
+        exitCode = -1;
+    }
+
+    return exitCode;
+}
+
+int main(int argc, char** argv) {
+    // Usage: host [--profile[=<dir>]] [--serial-init] [--config=<file>] [--warmup-ms=<n>]
+    //             [--input=<file> [--input-read] [--skip-demo]] [core_clr_path]
+    //        host --write-input=<file> [--input-mb=<n>]
+    HostOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--profile") == 0)
+            options.profileDir = "./profile";
+        else if (strncmp(argv[i], "--profile=", 10) == 0)
+            options.profileDir = argv[i] + 10;
+        else if (strcmp(argv[i], "--serial-init") == 0)
+            options.serialInit = true;
+        else if (strncmp(argv[i], "--config=", 9) == 0)
+            options.configPath = argv[i] + 9;
+        else if (strncmp(argv[i], "--warmup-ms=", 12) == 0)
+            options.warmupMs = strtod(argv[i] + 12, NULL);
+        else if (strncmp(argv[i], "--input=", 8) == 0)
+            options.inputPath = argv[i] + 8;
+        else if (strcmp(argv[i], "--input-read") == 0)
+            options.inputRead = true;
+        else if (strcmp(argv[i], "--skip-demo") == 0)
+            options.skipDemo = true;
+        else if (strncmp(argv[i], "--write-input=", 14) == 0)
+            options.writeInputPath = argv[i] + 14;
+        else if (strncmp(argv[i], "--input-mb=", 11) == 0)
+            options.inputMb = strtoul(argv[i] + 11, NULL, 10);
+        else
+            options.coreClrDir = argv[i];
+        // std::cerr << "Usage: host <core_clr_path>" << std::endl;
+        // return -1;
+    }
+
+    // Generating an input file does not need the runtime at all
+    if (options.writeInputPath != NULL) {
+        uint64_t count = (uint64_t)options.inputMb * 1024 * 1024 / sizeof(double);
+        if (!DataFileWrite(options.writeInputPath, count, 1)) {
+            return -1;
+        }
+        printf("Wrote %llu doubles (%lu MB) to %s\n", (unsigned long long)count, options.inputMb, options.writeInputPath);
+        return 0;
+    }
+
+    Clock::time_point startTime = Clock::now();
+
+    // Get the current executable's directory
+    // This sample assumes that both CoreCLR and the
+    // managed assembly to be loaded are next to this host
+    // so we need to get the current path in order to locate those.
+    char appPath[MAX_PATH];
+#if defined(OS_WIN)
+    GetFullPathNameA(argv[0], MAX_PATH, appPath, NULL);
+#else
+    realpath(argv[0], appPath);
+#endif
+
+    char *last_slash = strrchr(appPath, FS_SEPARATOR[0]);
+    if (last_slash != NULL)
+        *last_slash = 0;
+
+    // Profiling and tiering knobs are read from the environment by coreclr_initialize.
+    // Set them before the runtime thread starts, setenv is not thread safe.
+    if (options.profileDir != NULL && !ProfilerConfigureRuntime(options.profileDir)) {
+        return -1;
+    }
+    if (options.warmupMs > 0) {
+        WarmupConfigureRuntime();
     }
 
-    return 0;
+    // Bring the runtime up in the background while the host does its own
+    // startup; the host only waits for it right before the first managed call.
+    // --serial-init keeps the old behaviour (runtime first, then host startup)
+    // to measure the difference.
+    Runtime runtime;
+    double runtimeReadyMs = 0;
+    std::future<bool> runtimeReady = std::async(std::launch::async, [&]() {
+        bool ok = StartRuntime(appPath, options.coreClrDir, &runtime);
+        runtimeReadyMs = ElapsedMs(startTime);
+        return ok;
+    });
+
+    if (options.serialInit) {
+        runtimeReady.wait();
+    }
+
+    Clock::time_point hostStartTime = Clock::now();
+    HostStartup host;
+    bool hostStarted = StartHost(appPath, options.configPath, options.inputPath, options.inputRead, &host);
+    double hostStartupMs = ElapsedMs(hostStartTime);
+
+    // Wait for the runtime only if it is still starting. This also joins it when
+    // host startup failed: coreclr_initialize cannot be cancelled, and whatever
+    // part of the runtime did start is shut down below.
+    bool runtimeStarted = runtimeReady.get();
+
+    int exitCode = -1;
+    if (hostStarted && runtimeStarted) {
+        printf("Startup (%s): runtime ready after %.2f ms, host startup took %.2f ms "
+               "(config %.2f, listen %.2f, input %.2f), ready for managed calls after %.2f ms\n",
+               options.serialInit ? "serial" : "overlapped", runtimeReadyMs, hostStartupMs,
+               host.configMs, host.listenMs, host.inputMs, ElapsedMs(startTime));
+
+        exitCode = RunWorkload(options, runtime, host, startTime);
+    }
+
+    // Single cleanup path for success and every failure after the runtime thread started
+    StopRuntime(&runtime);
+    StopHost(&host);
+
+    return exitCode;
 }
 
 #if defined(OS_WIN)
@@ -412,6 +799,12 @@ int ReportProgressCallback(int progress)
     return -progress;
 }
 
+// Same contract as ReportProgressCallback without the output, for warmup calls
+int WarmupProgressCallback(int progress)
+{
+    return -progress;
+}
+
 // #include <iostream>
 // #include <limits.h>
 // #include <stdlib.h>
@@ -0,0 +1,135 @@
+//
+// Typed native <-> managed function pointers generated from interop.def
+//
+
+#ifndef __INTEROP_H__
+#define __INTEROP_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+#define INTEROP_MANAGED_ASSEMBLY    "ManagedLibrary, Version=1.0.0.0"
+#define INTEROP_EXPORTS_TYPE        "ManagedLibrary.NativeExports"     // generated [UnmanagedCallersOnly] stubs
+#define INTEROP_WORKER_TYPE         "ManagedLibrary.ManagedWorker"     // hand written, marshaled methods
+
+namespace interop
+{
+    // A type is blittable when it has the same representation on both sides
+    // and can be passed without a marshaling stub: primitive numbers, enums,
+    // pointers to those, and function pointers built from them.
+    // bool and wchar_t are excluded because the runtime marshals them
+    // (bool becomes a 4 byte BOOL, char is 2 bytes on the managed side).
+    template <typename T>
+    struct is_blittable : std::integral_constant<bool,
+        (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, wchar_t>::value) ||
+        std::is_enum<T>::value> {};
+
+    template <typename... Ts>
+    struct all_blittable : std::true_type {};
+
+    template <typename T, typename... Ts>
+    struct all_blittable<T, Ts...> : std::integral_constant<bool,
+        is_blittable<T>::value && all_blittable<Ts...>::value> {};
+
+    template <typename T>
+    struct is_blittable<T*> : std::integral_constant<bool,
+        std::is_void<typename std::remove_cv<T>::type>::value ||
+        is_blittable<typename std::remove_cv<T>::type>::value ||
+        (std::is_class<T>::value && std::is_standard_layout<T>::value && std::is_trivially_copyable<T>::value)> {};
+
+    template <typename R, typename... Args>
+    struct is_blittable<R (*)(Args...)> : std::integral_constant<bool,
+        (std::is_void<R>::value || is_blittable<R>::value) && all_blittable<Args...>::value> {};
+
+    // Size of a C# type keyword as written in the managed column of INTEROP_TYPE,
+    // looking only at its first `length` characters. 0 for unknown keywords.
+    // A trailing '*' makes it an unmanaged pointer.
+    constexpr bool ManagedKeywordIs(const char* managed, size_t length, const char* keyword)
+    {
+        return length == 0 ? *keyword == 0 :
+               *managed == *keyword && ManagedKeywordIs(managed + 1, length - 1, keyword + 1);
+    }
+
+    constexpr size_t ManagedSize(const char* managed, size_t length)
+    {
+        return length > 0 && managed[length - 1] == '*' ? sizeof(void*) :
+               ManagedKeywordIs(managed, length, "byte")   || ManagedKeywordIs(managed, length, "sbyte")  ? 1 :
+               ManagedKeywordIs(managed, length, "short")  || ManagedKeywordIs(managed, length, "ushort") ? 2 :
+               ManagedKeywordIs(managed, length, "int")    || ManagedKeywordIs(managed, length, "uint")   ||
+               ManagedKeywordIs(managed, length, "float")  ? 4 :
+               ManagedKeywordIs(managed, length, "long")   || ManagedKeywordIs(managed, length, "ulong")  ||
+               ManagedKeywordIs(managed, length, "double") ? 8 : 0;
+    }
+
+    // Size of what a managed pointer type points to, 0 if it is not a pointer
+    constexpr size_t ManagedPointeeSize(const char* managed, size_t length)
+    {
+        return length > 0 && managed[length - 1] == '*' ? ManagedSize(managed, length - 1) : 0;
+    }
+
+    template <typename T>
+    struct native_pointee_size : std::integral_constant<size_t, 0> {};
+
+    template <typename T>
+    struct native_pointee_size<T*> : std::integral_constant<size_t, sizeof(T)> {};
+
+    // Function pointer to a managed method, filled in by coreclr_create_delegate.
+    // Signatures that would need a marshaling stub fail to compile unless
+    // AllowMarshaling is set, which INTEROP_MARSHALED_ENTRY does explicitly.
+    template <typename Fn, bool AllowMarshaling>
+    class EntryPoint;
+
+    template <typename R, typename... Args, bool AllowMarshaling>
+    class EntryPoint<R (*)(Args...), AllowMarshaling>
+    {
+        static_assert(AllowMarshaling || std::is_void<R>::value || is_blittable<R>::value,
+                      "interop entry point returns a non-blittable type; use INTEROP_MARSHALED_ENTRY to allow a marshaling stub");
+        static_assert(AllowMarshaling || all_blittable<Args...>::value,
+                      "interop entry point takes a non-blittable parameter; use INTEROP_MARSHALED_ENTRY to allow a marshaling stub");
+
+    public:
+        typedef R (*pointer)(Args...);
+
+        EntryPoint() : m_fn(NULL) {}
+
+        R operator()(Args... args) const { return m_fn(args...); }
+
+        bool   valid() const    { return m_fn != NULL; }
+        void** address()        { return reinterpret_cast<void**>(&m_fn); }
+
+    private:
+        pointer m_fn;
+    };
+
+#define INTEROP_PARAM(type, name) type name
+
+#define INTEROP_TYPE(name, native, managed) \
+    typedef native name; \
+    static_assert(sizeof(name) == ManagedSize(#managed, sizeof(#managed) - 1), \
+                  "interop type " #name ": " #native " and " #managed " differ in size"); \
+    static_assert(native_pointee_size<name>::value == ManagedPointeeSize(#managed, sizeof(#managed) - 1), \
+                  "interop type " #name ": " #native " and " #managed " point to types of different size");
+
+#define INTEROP_CALLBACK(name, ret, params) \
+    typedef ret (*name) params; \
+    static_assert(is_blittable<name>::value, "interop callback " #name " has a non-blittable signature");
+
+#define INTEROP_ENTRY(name, ret, params) \
+    struct name : EntryPoint<ret (*) params, false> { \
+        static const char* type_name()   { return INTEROP_EXPORTS_TYPE; } \
+        static const char* method_name() { return #name; } \
+    };
+
+#define INTEROP_MARSHALED_ENTRY(name, ret, params) \
+    struct name : EntryPoint<ret (*) params, true> { \
+        static const char* type_name()   { return INTEROP_WORKER_TYPE; } \
+        static const char* method_name() { return #name; } \
+    };
+
+#include "interop.def"
+
+#undef INTEROP_PARAM
+}
+
+#endif // __INTEROP_H__
@@ -0,0 +1,154 @@
+// Generates the C# side of interop.def: an [UnmanagedCallersOnly] stub for
+// every INTEROP_ENTRY, forwarding to ManagedWorker with identical types.
+//
+// Usage: interopgen <output.cs>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct Param
+{
+    const char* type;
+    const char* name;
+};
+
+struct Signature
+{
+    const char*        name;
+    const char*        ret;
+    std::vector<Param> params;
+};
+
+struct TypeMapping
+{
+    const char* name;
+    std::string managed;
+};
+
+#define INTEROP_PARAM(type, name) { #type, #name }
+#define INTEROP_LIST(...) { __VA_ARGS__ }
+
+static std::vector<TypeMapping> g_types = {
+#define INTEROP_TYPE(name, native, managed) { #name, #managed },
+#include "interop.def"
+};
+
+static std::vector<Signature> g_callbacks = {
+#define INTEROP_CALLBACK(name, ret, params) { #name, #ret, INTEROP_LIST params },
+#include "interop.def"
+};
+
+static std::vector<Signature> g_entries = {
+#define INTEROP_ENTRY(name, ret, params) { #name, #ret, INTEROP_LIST params },
+#include "interop.def"
+};
+
+static const char* ManagedType(const char* type)
+{
+    for (size_t i = 0; i < g_types.size(); ++i)
+    {
+        if (strcmp(g_types[i].name, type) == 0)
+            return g_types[i].managed.c_str();
+    }
+
+    fprintf(stderr, "interopgen: unknown or non-blittable type '%s'\n", type);
+    return NULL;
+}
+
+// void is only valid as a return type and is the same keyword on both sides
+static const char* ManagedReturnType(const char* type)
+{
+    return strcmp(type, "void") == 0 ? "void" : ManagedType(type);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: interopgen <output.cs>\n");
+        return -1;
+    }
+
+    // Callbacks become usable as types: delegate* unmanaged<params..., ret>
+    for (size_t i = 0; i < g_callbacks.size(); ++i)
+    {
+        const Signature& cb = g_callbacks[i];
+        std::string managed("delegate* unmanaged<");
+        for (size_t j = 0; j < cb.params.size(); ++j)
+        {
+            const char* type = ManagedType(cb.params[j].type);
+            if (type == NULL)
+                return -1;
+            managed.append(type);
+            managed.append(", ");
+        }
+
+        const char* ret = ManagedReturnType(cb.ret);
+        if (ret == NULL)
+            return -1;
+        managed.append(ret);
+        managed.append(">");
+
+        TypeMapping mapping = { cb.name, managed };
+        g_types.push_back(mapping);
+    }
+
+    std::string out;
+    out.append("// <auto-generated>\n");
+    out.append("// Generated from src/interop.def by interopgen. Do not edit.\n");
+    out.append("// </auto-generated>\n");
+    out.append("using System.Runtime.InteropServices;\n\n");
+    out.append("namespace ManagedLibrary\n{\n");
+    out.append("    // Entry points bound by the native host through coreclr_create_delegate\n");
+    out.append("    public static unsafe class NativeExports\n    {\n");
+
+    for (size_t i = 0; i < g_entries.size(); ++i)
+    {
+        const Signature& entry = g_entries[i];
+        const char* ret = ManagedReturnType(entry.ret);
+        if (ret == NULL)
+            return -1;
+
+        std::string params;
+        std::string args;
+        for (size_t j = 0; j < entry.params.size(); ++j)
+        {
+            const char* type = ManagedType(entry.params[j].type);
+            if (type == NULL)
+                return -1;
+            if (j > 0)
+            {
+                params.append(", ");
+                args.append(", ");
+            }
+            params.append(type);
+            params.append(" ");
+            params.append(entry.params[j].name);
+            args.append(entry.params[j].name);
+        }
+
+        if (i > 0)
+            out.append("\n");
+        out.append("        [UnmanagedCallersOnly]\n");
+        out.append("        public static ").append(ret).append(" ").append(entry.name);
+        out.append("(").append(params).append(")\n");
+        out.append("        {\n");
+        out.append(strcmp(ret, "void") == 0 ? "            " : "            return ");
+        out.append("ManagedWorker.").append(entry.name).append("(").append(args).append(");\n");
+        out.append("        }\n");
+    }
+
+    out.append("    }\n}\n");
+
+    FILE* file = fopen(argv[1], "w");
+    if (file == NULL)
+    {
+        fprintf(stderr, "interopgen: failed to open %s\n", argv[1]);
+        return -1;
+    }
+    fputs(out.c_str(), file);
+    fclose(file);
+
+    return 0;
+}
@@ -0,0 +1,342 @@
+#include "profiler.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#if defined(_WIN32) || defined(__WIN32__)
+
+bool ProfilerConfigureRuntime(const char* outputDir)
+{
+    printf("ERROR: --profile is only supported on platforms with perf\n");
+    return false;
+}
+
+bool ProfilerStart(const char* outputDir)
+{
+    return false;
+}
+
+bool ProfilerStop()
+{
+    return false;
+}
+
+#else
+#   include <signal.h>
+#   include <spawn.h>
+#   include <unistd.h>
+#   include <sys/stat.h>
+#   include <sys/wait.h>
+
+extern char** environ;
+
+// perf samples at this frequency (Hz); odd to avoid lockstep with timers
+#define PROFILER_FREQUENCY "999"
+
+static std::string s_outputDir;
+static pid_t       s_perfPid = -1;
+
+// Sets a CLR config knob under both the current and the legacy prefix
+static void SetRuntimeKnob(const char* name, const char* value)
+{
+    std::string key("DOTNET_");
+    key.append(name);
+    setenv(key.c_str(), value, 1);
+
+    key.assign("COMPlus_");
+    key.append(name);
+    setenv(key.c_str(), value, 1);
+}
+
+bool ProfilerConfigureRuntime(const char* outputDir)
+{
+    s_outputDir.assign(outputDir);
+    if (mkdir(outputDir, 0755) != 0 && errno != EEXIST)
+    {
+        printf("ERROR: Failed to create profile directory %s\n", outputDir);
+        return false;
+    }
+
+    std::string tracePath(s_outputDir);
+    tracePath.append("/host.nettrace");
+
+    // Emit /tmp/perf-<pid>.map for JIT-compiled code so perf can name managed frames
+    SetRuntimeKnob("PerfMapEnabled", "1");
+
+    // JIT/loader/GC runtime events. CPU samples come from perf, so the
+    // Microsoft-DotNETCore-SampleProfiler provider is not enabled: combined with
+    // the runtime provider it crashes coreclr_initialize on .NET 6.
+    SetRuntimeKnob("EnableEventPipe", "1");
+    SetRuntimeKnob("EventPipeOutputPath", tracePath.c_str());
+    SetRuntimeKnob("EventPipeConfig", "Microsoft-Windows-DotNETRuntime:0x4c14fccbd:5");
+
+    return true;
+}
+
+bool ProfilerStart(const char* outputDir)
+{
+    s_outputDir.assign(outputDir);
+
+    std::string dataPath(s_outputDir);
+    dataPath.append("/host.perf.data");
+
+    char pid[32];
+    snprintf(pid, sizeof(pid), "%d", (int)getpid());
+
+    const char* args[] = {
+        "perf", "record", "-q", "-g",
+        "-F", PROFILER_FREQUENCY,
+        "-p", pid,
+        "-o", dataPath.c_str(),
+        NULL
+    };
+
+    if (posix_spawnp(&s_perfPid, "perf", NULL, NULL, (char* const*)args, environ) != 0)
+    {
+        printf("ERROR: Failed to start perf, is it installed?\n");
+        s_perfPid = -1;
+        return false;
+    }
+
+    // Give perf a moment to attach before the workload starts. If it has already
+    // exited it could not attach (e.g. perf_event_paranoid), and there is no profile.
+    usleep(500 * 1000);
+    int status = 0;
+    if (waitpid(s_perfPid, &status, WNOHANG) != 0)
+    {
+        printf("ERROR: perf record exited immediately, check perf_event_paranoid and its output above\n");
+        s_perfPid = -1;
+        return false;
+    }
+
+    printf("perf attached (pid %d), writing %s\n", (int)s_perfPid, dataPath.c_str());
+    return true;
+}
+
+// Turns one `perf script` frame line ("  addr symbol+0xoff (dso)") into a frame name
+static std::string ParseFrame(const char* line)
+{
+    while (*line == ' ' || *line == '\t')
+        ++line;
+
+    // Skip the address
+    while (*line != 0 && *line != ' ')
+        ++line;
+    while (*line == ' ')
+        ++line;
+
+    std::string frame(line);
+    while (!frame.empty() && (frame.back() == '\n' || frame.back() == ' '))
+        frame.pop_back();
+
+    std::string dso;
+    size_t dsoPos = frame.rfind(" (");
+    if (dsoPos != std::string::npos)
+    {
+        dso = frame.substr(dsoPos + 2, frame.length() - dsoPos - 3);
+        frame.erase(dsoPos);
+    }
+
+    size_t offsetPos = frame.rfind("+0x");
+    if (offsetPos != std::string::npos)
+        frame.erase(offsetPos);
+
+    // Unresolved frames are at least attributed to their module
+    if (frame.empty() || frame == "[unknown]")
+    {
+        size_t slash = dso.rfind('/');
+        frame = "[" + (slash == std::string::npos ? dso : dso.substr(slash + 1)) + "]";
+    }
+
+    // ';' separates frames in the folded format
+    for (size_t i = 0; i < frame.length(); ++i)
+    {
+        if (frame[i] == ';')
+            frame[i] = ':';
+    }
+
+    return frame;
+}
+
+// Extracts the thread name from a sample header ("comm pid/tid [cpu] time: period event:").
+// Thread names may contain spaces (".NET Tiered Compilation Worker"), so instead of
+// cutting at the first space, find the timestamp and take everything before the pid.
+static std::string ParseComm(const char* line)
+{
+    std::vector<std::pair<size_t, std::string> > tokens;
+    for (size_t i = 0; line[i] != 0;)
+    {
+        size_t length = strcspn(line + i, " \t\n");
+        if (length > 0)
+            tokens.push_back(std::make_pair(i, std::string(line + i, length)));
+        i += length > 0 ? length : 1;
+    }
+
+    for (size_t t = 1; t < tokens.size(); ++t)
+    {
+        const std::string& time = tokens[t].second;
+        if (time.empty() || time[time.length() - 1] != ':' || time.find('.') == std::string::npos ||
+            strspn(time.c_str(), "0123456789.:") != time.length())
+            continue;
+
+        // Optional "[cpu]" between pid and time
+        size_t pid = t - 1;
+        if (tokens[pid].second[0] == '[' && pid > 0)
+            --pid;
+        if (pid == 0)
+            break;
+
+        std::string comm(line, tokens[pid].first);
+        size_t begin = comm.find_first_not_of(" \t");
+        size_t end = comm.find_last_not_of(" \t");
+        return begin == std::string::npos ? std::string() : comm.substr(begin, end - begin + 1);
+    }
+
+    // Unknown header layout: fall back to the first token
+    return tokens.empty() ? std::string() : tokens[0].second;
+}
+
+// Reads `perf script` output, copies it to text and counts identical stacks
+static void FoldStacks(FILE* in, FILE* text, std::map<std::string, unsigned long>& folded)
+{
+    char line[8192];
+    std::string comm;
+    std::vector<std::string> frames;
+
+    for (;;)
+    {
+        bool eof = fgets(line, sizeof(line), in) == NULL;
+        if (!eof)
+            fputs(line, text);
+
+        // A blank line (or the end of input) terminates a sample
+        if (eof || line[0] == '\n')
+        {
+            if (!comm.empty() && !frames.empty())
+            {
+                // perf lists the leaf first, folded stacks start at the root
+                std::string stack(comm);
+                for (size_t i = frames.size(); i > 0; --i)
+                {
+                    stack.append(";");
+                    stack.append(frames[i - 1]);
+                }
+                folded[stack]++;
+            }
+            comm.clear();
+            frames.clear();
+
+            if (eof)
+                break;
+            continue;
+        }
+
+        // Frames are tab indented, headers may be space padded
+        if (line[0] != '\t')
+        {
+            comm = ParseComm(line);
+        }
+        else
+        {
+            frames.push_back(ParseFrame(line));
+        }
+    }
+}
+
+bool ProfilerStop()
+{
+    if (s_perfPid < 0)
+        return false;
+
+    // SIGINT makes perf flush and finalize the data file, then exit normally
+    kill(s_perfPid, SIGINT);
+    int status = 0;
+    waitpid(s_perfPid, &status, 0);
+    s_perfPid = -1;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        printf("ERROR: perf record failed (status 0x%x), no profile written\n", status);
+        return false;
+    }
+
+    std::string dataPath(s_outputDir);
+    dataPath.append("/host.perf.data");
+    std::string textPath(s_outputDir);
+    textPath.append("/host.perf.txt");
+    std::string foldedPath(s_outputDir);
+    foldedPath.append("/host.folded");
+
+    // The perf map of this (still running) process is picked up from /tmp automatically.
+    // perf script is spawned directly rather than through a shell, the output
+    // directory comes from the command line and must not be interpreted.
+    const char* args[] = {
+        "perf", "script", "-i", dataPath.c_str(),
+        NULL
+    };
+
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        printf("ERROR: Failed to run perf script\n");
+        return false;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, fds[0]);
+    posix_spawn_file_actions_addclose(&actions, fds[1]);
+
+    pid_t scriptPid = -1;
+    int spawned = posix_spawnp(&scriptPid, "perf", &actions, NULL, (char* const*)args, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+
+    FILE* script = spawned == 0 ? fdopen(fds[0], "r") : NULL;
+    FILE* text = fopen(textPath.c_str(), "w");
+    FILE* out = fopen(foldedPath.c_str(), "w");
+    if (script == NULL || text == NULL || out == NULL)
+    {
+        printf("ERROR: Failed to run perf script\n");
+        if (script != NULL) fclose(script); else close(fds[0]);
+        if (text != NULL) fclose(text);
+        if (out != NULL) fclose(out);
+        if (spawned == 0) waitpid(scriptPid, &status, 0);
+        return false;
+    }
+
+    std::map<std::string, unsigned long> folded;
+    FoldStacks(script, text, folded);
+
+    unsigned long samples = 0;
+    for (std::map<std::string, unsigned long>::const_iterator it = folded.begin(); it != folded.end(); ++it)
+    {
+        fprintf(out, "%s %lu\n", it->first.c_str(), it->second);
+        samples += it->second;
+    }
+
+    fclose(script);
+    waitpid(scriptPid, &status, 0);
+    fclose(text);
+    fclose(out);
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        printf("ERROR: perf script failed (status 0x%x), %s and %s are incomplete\n",
+               status, textPath.c_str(), foldedPath.c_str());
+        return false;
+    }
+
+    printf("Profile: %lu samples, %lu unique stacks\n", samples, (unsigned long)folded.size());
+    printf("  symbolized stacks: %s\n", textPath.c_str());
+    printf("  folded stacks:     %s (flamegraph.pl %s > host.svg)\n", foldedPath.c_str(), foldedPath.c_str());
+    printf("  managed trace:     %s/host.nettrace\n", s_outputDir.c_str());
+    return true;
+}
+
+#endif
@@ -0,0 +1,30 @@
+//
+// Mixed native/managed profiling for the host (--profile)
+//
+// The runtime is asked to write a perf map (/tmp/perf-<pid>.map) so that perf
+// can symbolize JIT-compiled frames, and an EventPipe trace of managed events.
+// perf itself is attached to the host process around the workload, and the
+// resulting samples are written both as symbolized `perf script` output and as
+// folded stacks ready for flamegraph.pl / speedscope.
+//
+// Output files in the profile directory:
+//  host.perf.data  - raw perf samples
+//  host.perf.txt   - merged native+managed symbolized stacks (perf script)
+//  host.folded     - one line per unique stack: "frame;frame;...;leaf count"
+//  host.nettrace   - EventPipe trace (managed sample profiler + runtime events)
+//
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+// Sets the runtime knobs for perf map and EventPipe output.
+// Must be called before coreclr_initialize, which reads them from the environment.
+bool ProfilerConfigureRuntime(const char* outputDir);
+
+// Attaches `perf record` to the current process
+bool ProfilerStart(const char* outputDir);
+
+// Stops perf and writes the symbolized and folded stacks
+bool ProfilerStop();
+
+#endif // __PROFILER_H__
@@ -0,0 +1,215 @@
+#include "warmup.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+#if defined(__linux__)
+#   include <sched.h>
+#endif
+
+// Every entry point is called at least this often, well above the default
+// tiering call count threshold (30) so each method gets queued for Tier-1
+#define WARMUP_MIN_ROUNDS       100
+
+// Call counting delay the host asks for unless the environment already sets one.
+// Tier-1 promotion only starts after the runtime has seen no Tier-0 activity for
+// this long; the runtime default is 100 ms, multiplied on single-CPU machines.
+#define WARMUP_CALL_COUNTING_DELAY_MS   0
+
+// Defaults of the runtime's TC_CallCountingDelayMs and TC_DelaySingleProcMultiplier
+#define RUNTIME_CALL_COUNTING_DELAY_MS  100
+#define RUNTIME_SINGLE_PROC_MULTIPLIER  10
+
+// JIT activity counts as settled once no method was compiled for the effective
+// call counting delay plus this margin, so a pending promotion wave is not missed
+#define WARMUP_QUIET_MARGIN_MS  200.0
+
+// Latency is reported in windows of this length
+#define WARMUP_WINDOW_MS        100.0
+
+typedef std::chrono::steady_clock Clock;
+
+// Latency of all calls made within one report window
+struct WarmupWindow
+{
+    unsigned long   calls;
+    double          totalUs;
+    double          maxUs;
+};
+
+struct WarmupEntry
+{
+    std::string                 name;
+    WarmupCall                  call;
+    unsigned long               calls;
+    double                      firstUs;
+    std::vector<WarmupWindow>   windows;
+};
+
+static std::vector<WarmupEntry> s_entries;
+static double                   s_quietMs = RUNTIME_CALL_COUNTING_DELAY_MS * RUNTIME_SINGLE_PROC_MULTIPLIER + WARMUP_QUIET_MARGIN_MS;
+
+// Reads a CLR config DWORD from the environment; like the runtime, values are hex
+static bool GetRuntimeKnob(const char* name, unsigned long& value)
+{
+    const char* prefixes[] = { "DOTNET_", "COMPlus_" };
+    for (size_t i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); ++i)
+    {
+        std::string key(prefixes[i]);
+        key.append(name);
+        const char* text = getenv(key.c_str());
+        if (text != NULL)
+        {
+            value = strtoul(text, NULL, 16);
+            return true;
+        }
+    }
+    return false;
+}
+
+// CPUs this process may run on, which is what the runtime's single-CPU check
+// looks at: the affinity mask where available, not the machine's CPU count.
+// The runtime also honours a cgroup CPU quota, which is not checked here; under
+// a quota below two CPUs the quiet window is too short and warmup just runs
+// out of budget instead of settling.
+static unsigned ProcessCpuCount()
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        return (unsigned)CPU_COUNT(&set);
+#endif
+    return std::thread::hardware_concurrency();
+}
+
+void WarmupConfigureRuntime()
+{
+    unsigned long delayMs = 0;
+    if (!GetRuntimeKnob("TC_CallCountingDelayMs", delayMs))
+    {
+        delayMs = WARMUP_CALL_COUNTING_DELAY_MS;
+        char value[32];
+        snprintf(value, sizeof(value), "%lx", delayMs);
+#if defined(_WIN32) || defined(__WIN32__)
+        _putenv_s("DOTNET_TC_CallCountingDelayMs", value);
+#else
+        setenv("DOTNET_TC_CallCountingDelayMs", value, 1);
+#endif
+        // This applies to the whole process, not only to the warmup phase
+        printf("Warmup: set DOTNET_TC_CallCountingDelayMs=%s for this process (default %d ms), "
+               "set it in the environment to override\n", value, RUNTIME_CALL_COUNTING_DELAY_MS);
+    }
+
+    unsigned long multiplier = RUNTIME_SINGLE_PROC_MULTIPLIER;
+    GetRuntimeKnob("TC_DelaySingleProcMultiplier", multiplier);
+    if (ProcessCpuCount() > 1)
+        multiplier = 1;
+
+    s_quietMs = (double)(delayMs * multiplier) + WARMUP_QUIET_MARGIN_MS;
+}
+
+static double ElapsedMs(Clock::time_point since, Clock::time_point now)
+{
+    return std::chrono::duration<double, std::milli>(now - since).count();
+}
+
+void WarmupRegister(const char* name, WarmupCall call)
+{
+    WarmupEntry entry;
+    entry.name.assign(name);
+    entry.call = call;
+    entry.calls = 0;
+    entry.firstUs = 0;
+    s_entries.push_back(entry);
+}
+
+static void Record(WarmupEntry& entry, double timeMs, double latencyUs)
+{
+    if (entry.calls++ == 0)
+        entry.firstUs = latencyUs;
+
+    size_t window = (size_t)(timeMs / WARMUP_WINDOW_MS);
+    if (entry.windows.size() <= window)
+    {
+        WarmupWindow empty = { 0, 0, 0 };
+        entry.windows.resize(window + 1, empty);
+    }
+
+    WarmupWindow& w = entry.windows[window];
+    w.calls++;
+    w.totalUs += latencyUs;
+    if (latencyUs > w.maxUs)
+        w.maxUs = latencyUs;
+}
+
+static void PrintReport(const WarmupEntry& entry)
+{
+    if (entry.calls == 0)
+        return;
+
+    printf("  %s: %lu calls, first call %.1f us\n", entry.name.c_str(), entry.calls, entry.firstUs);
+
+    for (size_t i = 0; i < entry.windows.size(); ++i)
+    {
+        const WarmupWindow& w = entry.windows[i];
+        if (w.calls == 0)
+            continue;
+
+        printf("    %5.0f - %5.0f ms: %8lu calls, mean %9.2f us, max %9.2f us\n",
+               i * WARMUP_WINDOW_MS, (i + 1) * WARMUP_WINDOW_MS, w.calls, w.totalUs / w.calls, w.maxUs);
+    }
+}
+
+bool WarmupRun(double budgetMs, WarmupJitCount jitCount)
+{
+    Clock::time_point start = Clock::now();
+    Clock::time_point lastChange = start;
+    int64_t firstCount = jitCount();
+    int64_t lastCount = firstCount;
+    unsigned long rounds = 0;
+    bool promoted = false;
+    bool settled = false;
+
+    while (ElapsedMs(start, Clock::now()) < budgetMs)
+    {
+        for (size_t i = 0; i < s_entries.size(); ++i)
+        {
+            Clock::time_point before = Clock::now();
+            s_entries[i].call();
+            Clock::time_point after = Clock::now();
+
+            Record(s_entries[i], ElapsedMs(start, before), ElapsedMs(before, after) * 1000.0);
+        }
+        ++rounds;
+
+        Clock::time_point now = Clock::now();
+        int64_t count = jitCount();
+        if (count != lastCount)
+        {
+            // The first round JIT compiles everything at Tier-0. Anything compiled
+            // after it is a promotion (or a late Tier-0 method, covered by waiting
+            // out the call counting delay in the quiet window).
+            promoted = promoted || rounds > 1;
+            lastCount = count;
+            lastChange = now;
+        }
+        else if (promoted && rounds >= WARMUP_MIN_ROUNDS && ElapsedMs(lastChange, now) >= s_quietMs)
+        {
+            settled = true;
+            break;
+        }
+    }
+
+    printf("Warmup %s after %.0f ms: %lu rounds, %lld methods JIT compiled during warmup (quiet window %.0f ms)\n",
+           settled ? "settled" : "ran out of budget", ElapsedMs(start, Clock::now()),
+           rounds, (long long)(lastCount - firstCount), s_quietMs);
+    for (size_t i = 0; i < s_entries.size(); ++i)
+        PrintReport(s_entries[i]);
+
+    return settled;
+}
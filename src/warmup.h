@@ -0,0 +1,39 @@
+//
+// JIT warmup before the host reports ready
+//
+// Right after coreclr_initialize every managed method runs unoptimized Tier-0
+// code, and the first calls also pay for JIT compilation. The warmup phase
+// calls every registered entry point with synthetic inputs until the runtime
+// stops compiling methods (tiered compilation has promoted the hot ones to
+// Tier-1) or the time budget runs out, and reports per-call latency over time
+// so the budget can be sized.
+//
+
+#ifndef __WARMUP_H__
+#define __WARMUP_H__
+
+#include <stdint.h>
+#include <functional>
+
+// One call of an entry point with synthetic inputs
+typedef std::function<void()> WarmupCall;
+
+// Number of methods the runtime has JIT compiled so far
+typedef std::function<int64_t()> WarmupJitCount;
+
+// Sets the runtime's tiered compilation call counting delay (unless the
+// environment already does, logged when overridden; it affects the whole
+// process) and sizes the quiet window from it.
+// Must be called before coreclr_initialize, which reads it from the environment.
+void WarmupConfigureRuntime();
+
+// Adds an entry point to drive during warmup
+void WarmupRegister(const char* name, WarmupCall call);
+
+// Runs the registered entry points until methods have been promoted past
+// Tier-0 and JIT activity has then stayed quiet for longer than the call
+// counting delay, or budgetMs elapses. Prints the latency report and
+// returns true if it settled.
+bool WarmupRun(double budgetMs, WarmupJitCount jitCount);
+
+#endif // __WARMUP_H__